@@ -0,0 +1,297 @@
+//
+//  GizmoBatch.cpp
+//  SceneGraph
+//
+
+#include "GizmoBatch.h"
+#include "GizmoCore.h"
+
+#include <algorithm>
+#include <cstddef>
+
+
+namespace {
+
+    struct Vertex {
+        ci::Vec3f   mPosition;
+        float       mAxis;
+    };
+
+    // Appends a cylinder (or a cone when topRadius is 0) going from y0 to y1 along the Y axis,
+    // oriented by m. Same conventions as ci::gl::drawCylinder, counter-clockwise seen from outside.
+    void appendCylinder( std::vector< Vertex > *vertices, const ci::Matrix44f &m, float axis, float baseRadius, float topRadius, float y0, float y1, int slices, bool capped ){
+        for( int i = 0; i < slices; ++i ){
+            float a0 = i / (float) slices * 2.0f * M_PI;
+            float a1 = ( i + 1 ) / (float) slices * 2.0f * M_PI;
+
+            ci::Vec3f b0( cos( a0 ) * baseRadius, y0, sin( a0 ) * baseRadius );
+            ci::Vec3f b1( cos( a1 ) * baseRadius, y0, sin( a1 ) * baseRadius );
+            ci::Vec3f t0( cos( a0 ) * topRadius, y1, sin( a0 ) * topRadius );
+            ci::Vec3f t1( cos( a1 ) * topRadius, y1, sin( a1 ) * topRadius );
+
+            ci::Vec3f quad[6] = { b0, t0, b1, b1, t0, t1 };
+            for( int j = 0; j < 6; ++j ){
+                Vertex v = { m.transformPoint( quad[j] ), axis };
+                vertices->push_back( v );
+            }
+
+            if( capped ){
+                ci::Vec3f cap[3] = { ci::Vec3f( 0.0f, y0, 0.0f ), b0, b1 };
+                for( int j = 0; j < 3; ++j ){
+                    Vertex v = { m.transformPoint( cap[j] ), axis };
+                    vertices->push_back( v );
+                }
+            }
+        }
+    }
+
+    void appendCube( std::vector< Vertex > *vertices, ci::Vec3f center, ci::Vec3f size, float axis ){
+        static const int faces[6][4] = {
+            { 1, 5, 7, 3 }, { 4, 0, 2, 6 }, { 2, 3, 7, 6 },
+            { 4, 5, 1, 0 }, { 5, 4, 6, 7 }, { 0, 1, 3, 2 }
+        };
+
+        ci::Vec3f corners[8];
+        for( int i = 0; i < 8; ++i ){
+            corners[i] = center + ci::Vec3f( ( i & 1 ) ? 0.5f : -0.5f, ( i & 2 ) ? 0.5f : -0.5f, ( i & 4 ) ? 0.5f : -0.5f ) * size;
+        }
+
+        for( int f = 0; f < 6; ++f ){
+            int indices[6] = { faces[f][0], faces[f][1], faces[f][2], faces[f][0], faces[f][2], faces[f][3] };
+            for( int j = 0; j < 6; ++j ){
+                Vertex v = { corners[ indices[j] ], axis };
+                vertices->push_back( v );
+            }
+        }
+    }
+
+    // Rotations bringing the Y axis onto X, Y and Z
+    ci::Matrix44f axisOrientation( int axis ){
+        switch( axis ){
+            case 0: return ci::Matrix44f::createRotation( ci::Vec3f::zAxis(), -M_PI * 0.5f );
+            case 2: return ci::Matrix44f::createRotation( ci::Vec3f::xAxis(), M_PI * 0.5f );
+        }
+        return ci::Matrix44f::identity();
+    }
+
+    // Rotations of the rings, same as GizmoCore::RotateMode::draw: the X ring is the unrotated cylinder
+    ci::Matrix44f ringOrientation( int axis ){
+        switch( axis ){
+            case 1: return ci::Matrix44f::createRotation( ci::Vec3f::zAxis(), M_PI * 0.5f );
+            case 2: return ci::Matrix44f::createRotation( ci::Vec3f::xAxis(), M_PI * 0.5f );
+        }
+        return ci::Matrix44f::identity();
+    }
+
+    const char* VERTEX_SHADER =
+        "#version 120\n"
+        "attribute vec3  aPosition;\n"
+        "attribute float aAxis;\n"
+        "attribute vec4  aTransform0;\n"
+        "attribute vec4  aTransform1;\n"
+        "attribute vec4  aTransform2;\n"
+        "attribute vec4  aTransform3;\n"
+        "attribute vec2  aScaleAxis;\n"
+        "varying vec4 vColor;\n"
+        "void main(){\n"
+        "    mat4 transform = mat4( aTransform0, aTransform1, aTransform2, aTransform3 );\n"
+        "    gl_Position = gl_ModelViewProjectionMatrix * transform * vec4( aPosition * aScaleAxis.x, 1.0 );\n"
+        "    vec3 color = vec3( float( aAxis < 0.5 ), float( aAxis > 0.5 && aAxis < 1.5 ), float( aAxis > 1.5 ) );\n"
+        "    if( abs( aAxis - aScaleAxis.y ) < 0.5 ) color = vec3( 1.0, 1.0, 0.0 );\n"
+        "    vColor = vec4( color, 1.0 );\n"
+        "}\n";
+
+    const char* FRAGMENT_SHADER =
+        "#version 120\n"
+        "varying vec4 vColor;\n"
+        "void main(){\n"
+        "    gl_FragColor = vColor;\n"
+        "}\n";
+}
+
+
+GizmoBatchRef GizmoBatch::create( float gizmoScale ){
+    GizmoBatchRef batch         = GizmoBatchRef( new GizmoBatch() );
+    batch->mSize                = gizmoScale;
+    batch->mInstancesDirty      = true;
+    batch->mNumThreads          = 1;
+
+    // Without these the entry points used by draw are null, fall back to a draw call per gizmo
+    batch->mInstancingAvailable = ci::gl::isExtensionAvailable( "GL_ARB_instanced_arrays" ) && ci::gl::isExtensionAvailable( "GL_ARB_draw_instanced" );
+
+    batch->setupGeometry();
+    batch->setupShader();
+
+    return batch;
+}
+
+void GizmoBatch::clear(){
+    mSources.clear();
+    mInstances.clear();
+}
+void GizmoBatch::reserve( size_t count ){
+    mSources.reserve( count );
+}
+
+void GizmoBatch::add( ci::Vec3f position, ci::Quatf rotations, int selectedAxis ){
+    Source source = { position, rotations, selectedAxis };
+    mSources.push_back( source );
+}
+void GizmoBatch::add( ci::Matrix44f m, int selectedAxis ){
+    // Remove the scaling the same way GizmoCore::decompose does
+    ci::Vec3f columns[3] = {
+        m.getColumn(0).xyz(),
+        m.getColumn(1).xyz(),
+        m.getColumn(2).xyz()
+    };
+    for( int i = 0; i < 3; ++i ){
+        float scale = columns[i].length();
+        if( scale ) columns[i] /= scale;
+    }
+    ci::Matrix33f rotations(columns[0].x,columns[1].x,columns[2].x,
+                            columns[0].y,columns[1].y,columns[2].y,
+                            columns[0].z,columns[1].z,columns[2].z, true);
+
+    add( ci::Vec3f( m.at(0, 3), m.at(1, 3), m.at(2, 3) ), ci::Quatf( rotations ), selectedAxis );
+}
+
+
+void GizmoBatch::setNumThreads( size_t numThreads ){
+    mNumThreads = std::max< size_t >( numThreads, 1 );
+}
+
+void GizmoBatch::setMatrices( ci::CameraPersp cam ){
+    buildGizmoInstances( mSources, cam.getEyePoint(), mSize, &mInstances, mNumThreads );
+    mInstancesDirty = true;
+}
+
+void GizmoBatch::draw( int mode ){
+    if( mInstances.empty() || mode < GizmoCore::TRANSLATE || mode > GizmoCore::SCALE ) return;
+
+    mShader.bind();
+
+    // Handles geometry
+    GLint positionLocation  = mShader.getAttribLocation( "aPosition" );
+    GLint axisLocation      = mShader.getAttribLocation( "aAxis" );
+
+    mGeometryVbo.bind();
+    glEnableVertexAttribArray( positionLocation );
+    glVertexAttribPointer( positionLocation, 3, GL_FLOAT, GL_FALSE, sizeof( Vertex ), (const GLvoid*) offsetof( Vertex, mPosition ) );
+    glEnableVertexAttribArray( axisLocation );
+    glVertexAttribPointer( axisLocation, 1, GL_FLOAT, GL_FALSE, sizeof( Vertex ), (const GLvoid*) offsetof( Vertex, mAxis ) );
+
+    // Per instance attributes
+    GLint transformLocations[4] = {
+        mShader.getAttribLocation( "aTransform0" ),
+        mShader.getAttribLocation( "aTransform1" ),
+        mShader.getAttribLocation( "aTransform2" ),
+        mShader.getAttribLocation( "aTransform3" )
+    };
+    GLint scaleAxisLocation = mShader.getAttribLocation( "aScaleAxis" );
+
+    // Same as GizmoCore::RotateMode::draw, only the outside of the rings is visible
+    if( mode == GizmoCore::ROTATE ){
+        glEnable( GL_CULL_FACE );
+        glCullFace( GL_BACK );
+    }
+
+    if( mInstancingAvailable ){
+        // Upload the instance buffer only when it changed
+        mInstanceVbo.bind();
+        if( mInstancesDirty ){
+            mInstanceVbo.bufferData( mInstances.size() * sizeof( Instance ), &mInstances[0], GL_STREAM_DRAW );
+            mInstancesDirty = false;
+        }
+
+        for( int i = 0; i < 4; ++i ){
+            glEnableVertexAttribArray( transformLocations[i] );
+            glVertexAttribPointer( transformLocations[i], 4, GL_FLOAT, GL_FALSE, sizeof( Instance ), (const GLvoid*) ( i * 4 * sizeof( float ) ) );
+            glVertexAttribDivisorARB( transformLocations[i], 1 );
+        }
+        glEnableVertexAttribArray( scaleAxisLocation );
+        glVertexAttribPointer( scaleAxisLocation, 2, GL_FLOAT, GL_FALSE, sizeof( Instance ), (const GLvoid*) offsetof( Instance, mScale ) );
+        glVertexAttribDivisorARB( scaleAxisLocation, 1 );
+
+        glDrawArraysInstancedARB( GL_TRIANGLES, mFirstVertex[ mode ], mNumVertices[ mode ], mInstances.size() );
+
+        for( int i = 0; i < 4; ++i ){
+            glVertexAttribDivisorARB( transformLocations[i], 0 );
+            glDisableVertexAttribArray( transformLocations[i] );
+        }
+        glVertexAttribDivisorARB( scaleAxisLocation, 0 );
+        glDisableVertexAttribArray( scaleAxisLocation );
+
+        mInstanceVbo.unbind();
+    }
+    else {
+        // No instancing, same shader but one draw call per gizmo with constant attributes
+        for( size_t i = 0; i < mInstances.size(); ++i ){
+            const Instance &instance = mInstances[i];
+            for( int j = 0; j < 4; ++j ){
+                glVertexAttrib4fv( transformLocations[j], &instance.mTransform.m[ j * 4 ] );
+            }
+            glVertexAttrib2f( scaleAxisLocation, instance.mScale, instance.mSelectedAxis );
+            glDrawArrays( GL_TRIANGLES, mFirstVertex[ mode ], mNumVertices[ mode ] );
+        }
+    }
+
+    if( mode == GizmoCore::ROTATE ){
+        glDisable( GL_CULL_FACE );
+    }
+
+    glDisableVertexAttribArray( positionLocation );
+    glDisableVertexAttribArray( axisLocation );
+
+    mGeometryVbo.unbind();
+    mShader.unbind();
+}
+
+GizmoBatch::GizmoBatch(){
+}
+
+void GizmoBatch::setupGeometry(){
+    // Same dimensions as the GizmoCore mode policies draw. Lines become thin
+    // cylinders so every mode fits in a single GL_TRIANGLES call. The rotate mode screen circle is left out.
+    float axisLength    = 30.0f;
+    float lineRadius    = 0.3f;
+    int slices          = 12;
+
+    std::vector< Vertex > vertices;
+
+    // Translate
+    mFirstVertex[ GizmoCore::TRANSLATE ] = vertices.size();
+    for( int axis = 0; axis < 3; ++axis ){
+        float headLength = 6.0f;
+        float headRadius = 1.5f;
+        // Like ci::gl::drawVector, the head starts where the shaft ends
+        appendCylinder( &vertices, axisOrientation( axis ), axis, lineRadius, lineRadius, 0.0f, axisLength, slices, false );
+        appendCylinder( &vertices, axisOrientation( axis ), axis, headRadius, 0.0f, axisLength, axisLength + headLength, slices, true );
+    }
+    mNumVertices[ GizmoCore::TRANSLATE ] = vertices.size() - mFirstVertex[ GizmoCore::TRANSLATE ];
+
+    // Rotate
+    mFirstVertex[ GizmoCore::ROTATE ] = vertices.size();
+    for( int axis = 0; axis < 3; ++axis ){
+        appendCylinder( &vertices, ringOrientation( axis ), axis, axisLength, axisLength, 0.0f, 2.0f, 30, false );
+    }
+    mNumVertices[ GizmoCore::ROTATE ] = vertices.size() - mFirstVertex[ GizmoCore::ROTATE ];
+
+    // Scale
+    mFirstVertex[ GizmoCore::SCALE ] = vertices.size();
+    for( int axis = 0; axis < 3; ++axis ){
+        ci::Vec3f direction = axisOrientation( axis ).transformVec( ci::Vec3f::yAxis() );
+        appendCylinder( &vertices, axisOrientation( axis ), axis, lineRadius, lineRadius, 0.0f, axisLength, slices, false );
+        appendCube( &vertices, direction * axisLength, ci::Vec3f( 3.0f, 3.0f, 3.0f ), axis );
+    }
+    mNumVertices[ GizmoCore::SCALE ] = vertices.size() - mFirstVertex[ GizmoCore::SCALE ];
+
+    mGeometryVbo = ci::gl::Vbo( GL_ARRAY_BUFFER );
+    mGeometryVbo.bufferData( vertices.size() * sizeof( Vertex ), &vertices[0], GL_STATIC_DRAW );
+    mGeometryVbo.unbind();
+
+    mInstanceVbo = ci::gl::Vbo( GL_ARRAY_BUFFER );
+}
+
+void GizmoBatch::setupShader(){
+    mShader = ci::gl::GlslProg( VERTEX_SHADER, FRAGMENT_SHADER );
+}
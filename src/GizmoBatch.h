@@ -0,0 +1,74 @@
+//
+//  GizmoBatch.h
+//  SceneGraph
+//
+//  Draws a large number of lightweight, display-only gizmos with
+//  one instanced draw call per mode (one call per gizmo when the
+//  instancing extensions are missing). The per-instance buffer is built
+//  on the CPU by buildGizmoInstances, see GizmoInstances.h.
+//
+
+#pragma once
+
+#include "cinder/gl/gl.h"
+#include "cinder/gl/Vbo.h"
+#include "cinder/gl/GlslProg.h"
+#include "cinder/Vector.h"
+#include "cinder/Quaternion.h"
+#include "cinder/Matrix.h"
+#include "cinder/Camera.h"
+
+#include "GizmoInstances.h"
+
+#include <vector>
+
+
+typedef std::shared_ptr< class GizmoBatch > GizmoBatchRef;
+
+class GizmoBatch {
+public:
+
+    static GizmoBatchRef create( float gizmoScale = 1.0f );
+
+    typedef GizmoInstanceSource Source;
+    typedef GizmoInstance       Instance;
+
+    void clear();
+    void reserve( size_t count );
+    void add( ci::Vec3f position, ci::Quatf rotations, int selectedAxis = -1 );
+    void add( ci::Matrix44f m, int selectedAxis = -1 );
+
+    size_t getNumGizmos() const { return mSources.size(); }
+    const std::vector< Instance >& getInstances() const { return mInstances; }
+
+    // Threads used to build the instance buffer in setMatrices, 1 builds it on the calling thread
+    void setNumThreads( size_t numThreads );
+    size_t getNumThreads() const { return mNumThreads; }
+
+    void setMatrices( ci::CameraPersp cam );
+
+    void draw( int mode );
+
+protected:
+
+    GizmoBatch();
+
+    void setupGeometry();
+    void setupShader();
+
+    ci::gl::GlslProg        mShader;
+    ci::gl::Vbo             mGeometryVbo;
+    ci::gl::Vbo             mInstanceVbo;
+
+    GLint                   mFirstVertex[3];
+    GLsizei                 mNumVertices[3];
+
+    std::vector< Source >   mSources;
+    std::vector< Instance > mInstances;
+    bool                    mInstancesDirty;
+    bool                    mInstancingAvailable;
+
+    float                   mSize;
+    size_t                  mNumThreads;
+
+};
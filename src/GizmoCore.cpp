@@ -0,0 +1,211 @@
+//
+//  GizmoCore.cpp
+//  SceneGraph
+//
+//  Created by Simon Geilfus on 22/03/12.
+//
+
+#include "GizmoCore.h"
+
+
+
+
+void GizmoCore::setup( ci::Vec2i viewportSize, float gizmoScale, float samplingDefinition ){
+    mWindowSize                 = ci::Rectf( 0, 0, viewportSize.x, viewportSize.y );
+    
+    ci::gl::Fbo::Format format;
+    format.enableColorBuffer();
+    format.setColorInternalFormat( GL_RGBA );
+    format.setSamples( 0 );
+    
+    mPositionFbo                = ci::gl::Fbo( viewportSize.x * samplingDefinition, viewportSize.y * samplingDefinition, format );
+    mCursorFbo                  = ci::gl::Fbo( 5, 5, format );
+    mSelectedAxis               = -1;
+    mPosition                   = ci::Vec3f( 0.0f, 0.0f, 0.0f );
+    mRotations                  = ci::Quatf();
+    mScale                      = ci::Vec3f( 1.0f, 1.0f, 1.0f );
+    mArcball                    = ci::Arcball( viewportSize );
+	mSize                       = gizmoScale;
+}
+
+
+void GizmoCore::transform(){
+    // Create the transformation matrix, I guess some of the rotations problem are here
+    mTransform.setToIdentity();
+	mTransform.translate( mPosition );
+    mTransform *= mRotations;
+    mUnscaledTransform = mTransform;
+    mTransform.scale( mScale );
+}
+
+void GizmoCore::setTranslate( ci::Vec3f v ){ 
+	mPosition = v; 
+    transform();
+}
+void GizmoCore::setRotate( ci::Quatf q ){ 
+	mRotations = q; 
+    transform();
+}
+void GizmoCore::setScale( ci::Vec3f v ){ 
+	mScale = v; 
+    transform();
+}
+
+
+void GizmoCore::setTransform( ci::Vec3f position, ci::Quatf rotations, ci::Vec3f scale ){
+    mPosition   = position;
+    mRotations  = rotations;
+    mScale      = scale;
+    transform();
+}
+void GizmoCore::setTransform( ci::Matrix44f m ){
+    mTransform = m;
+    decompose();
+}
+
+ci::Vec3f GizmoCore::getTranslate(){ 
+	return mPosition; 
+}
+ci::Quatf GizmoCore::getRotate(){ 
+	return mRotations; 
+}
+ci::Vec3f GizmoCore::getScale(){ 
+	return mScale; 
+}
+ci::Matrix44f GizmoCore::getTransform(){
+    return mTransform;
+}
+
+void GizmoCore::decompose (){
+    // extract translation
+    mPosition.x = mTransform.at(0, 3);
+    mPosition.y = mTransform.at(1, 3);
+    mPosition.z = mTransform.at(2, 3);
+    
+    // extract the rows of the matrix
+    
+    ci::Vec3f columns[3] = {
+        mTransform.getColumn(0).xyz(),
+        mTransform.getColumn(1).xyz(),
+        mTransform.getColumn(2).xyz()
+    };
+    
+    // extract the scaling factors
+    mScale.x = columns[0].length();
+    mScale.y = columns[1].length();
+    mScale.z = columns[2].length();
+    
+    // and remove all scaling from the matrix
+    if(mScale.x)
+    {
+        columns[0] /= mScale.x;
+    }
+    if(mScale.y)
+    {
+        columns[1] /= mScale.y;
+    }
+    if(mScale.z)
+    {
+        columns[2] /= mScale.z;
+    }
+    
+    // build a 3x3 rotation matrix
+    ci::Matrix33f m(columns[0].x,columns[1].x,columns[2].x,
+                columns[0].y,columns[1].y,columns[2].y,
+                columns[0].z,columns[1].z,columns[2].z, true);
+    
+    // and generate the rotation quaternion from it
+    mRotations = ci::Quatf(m);
+}
+
+void GizmoCore::unregisterEvents(){
+    if( mCallbackIds.size() ){
+        ci::app::App::get()->unregisterMouseDown(	mCallbackIds[ 0 ] );
+        ci::app::App::get()->unregisterMouseMove(	mCallbackIds[ 1 ] );
+        ci::app::App::get()->unregisterMouseDrag(	mCallbackIds[ 2 ] );
+        ci::app::App::get()->unregisterResize(      mCallbackIds[ 3 ] );
+    }
+}
+
+// Scale or translate
+void GizmoCore::planeMouseDown( ci::app::MouseEvent event ){
+    
+    // Find the plane for the selected axis
+    ci::Planef plane;
+    switch( mSelectedAxis ){
+        case 0: plane = ci::Planef( mPosition, ci::Vec3f::yAxis() ); break;
+        case 1: plane = ci::Planef( mPosition, ci::Vec3f::zAxis() ); break;
+        case 2: plane = ci::Planef( mPosition, ci::Vec3f::yAxis() ); break;
+        default: return;
+    }
+    
+    // Cast a ray from the camera
+    ci::Ray ray = mCurrentCam.generateRay( event.getPos().x / (float) mWindowSize.getWidth(), 1.0f - event.getPos().y / (float) mWindowSize.getHeight(), mWindowSize.getWidth() / (float) mWindowSize.getHeight() );
+    
+    // And check if there's an intersection with the plane
+    float intersectionDistance;
+    bool intersect = ray.calcPlaneIntersection( plane.getPoint(), plane.getNormal(), &intersectionDistance );
+    
+    // Use it to get the mouse position in 3D
+    if( intersect ){
+        ci::Vec3f intersection = ray.getOrigin() + ray.getDirection() * intersectionDistance;
+        mMousePos = intersection;
+    }
+}
+
+bool GizmoCore::resize( ci::app::ResizeEvent event ){
+    mWindowSize = ci::Rectf( 0, 0, event.getSize().x, event.getSize().y );
+    return false;
+}
+
+GizmoCore::GizmoCore(){
+}
+
+int GizmoCore::samplePosition( int x, int y ){
+    
+    y  = mPositionFbo.getHeight() - y;
+    
+    // Copy Cursor Neighbors to the cursor Fbo
+    
+    mPositionFbo.blitTo( mCursorFbo, ci::Area( x-5, y-5, x+5, y+5), mCursorFbo.getBounds());
+    
+    mCursorFbo.bindFramebuffer();
+    
+    GLubyte buffer[400];
+    glReadBuffer(GL_COLOR_ATTACHMENT0_EXT);
+    glReadPixels(0, 0, mCursorFbo.getWidth(), mCursorFbo.getHeight(), GL_RGBA, GL_UNSIGNED_BYTE, (void*)buffer);
+    
+    mCursorFbo.unbindFramebuffer();
+    
+    
+    // Sample the area and count the occurences of red, green and blue
+    
+    unsigned int total  = (mCursorFbo.getWidth() * mCursorFbo.getHeight());
+    unsigned int color, reds = 0, greens = 0, blues = 0;
+    unsigned int red    = 0xff0000;
+    unsigned int green  = 0x00ff00;
+    unsigned int blue   = 0x0000ff; 
+    
+    
+    for(size_t i=0;i<total;++i) {
+        color = charToInt( buffer[(i*4)+0], buffer[(i*4)+1], buffer[(i*4)+2] );
+        if( color == red ) reds++;
+        else if( color == green ) greens++;
+        else if( color == blue ) blues++;
+    }
+    
+    // Return the selected axis
+    
+    int axis = -1;
+    if( reds + greens + blues > 0 ) {
+        axis = ( reds > blues && reds > greens ) ? 0 : ( greens > blues && greens > reds ) ? 1 : 2;
+    }
+    
+    return axis;
+}
+
+
+ci::ColorA GizmoCore::RED = ci::ColorA( 1.0f, 0.0f, 0.0f, 1.0f);
+ci::ColorA GizmoCore::GREEN = ci::ColorA( 0.0f, 1.0f, 0.0f, 1.0f);
+ci::ColorA GizmoCore::BLUE = ci::ColorA( 0.0f, 0.0f, 1.0f, 1.0f);
+ci::ColorA GizmoCore::YELLOW = ci::ColorA( 1.0f, 1.0f, 0.0f, 1.0f);
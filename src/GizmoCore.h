@@ -0,0 +1,237 @@
+//
+//  GizmoCore.h
+//  SceneGraph
+//
+//  Mode independent part of the gizmo: transform, picking and the
+//  per mode code paths as templates. Gizmo switches modes at runtime,
+//  StaticGizmo fixes one at compile time. The mode policies are in
+//  GizmoModes.h.
+//
+//  Fbo.blitTo trick, charToInt and area color sampling taken from
+//  Paul Houx 3D picking sample  :
+//  http://forum.libcinder.org/topic/fast-object-picking-using-multiple-render-targets
+//
+//  Decompose matrix method from Assimp library:
+//  http://assimp.sourceforge.net/
+//
+
+#pragma once
+
+#include "cinder/app/App.h"
+#include "cinder/gl/Fbo.h"
+#include "cinder/Vector.h"
+#include "cinder/Camera.h"
+#include "cinder/Matrix.h"
+#include "cinder/CinderMath.h"
+#include "cinder/Plane.h"
+#include "cinder/Arcball.h"
+
+
+class GizmoCore {
+public:
+
+    enum {
+        TRANSLATE,
+        ROTATE,
+        SCALE
+    };
+
+    // Mode policies, see GizmoModes.h
+    class TranslateMode;
+    class RotateMode;
+    class ScaleMode;
+
+    void setTranslate( ci::Vec3f v );
+    void setRotate( ci::Quatf q );
+    void setScale( ci::Vec3f v );
+    void setTransform( ci::Vec3f position, ci::Quatf rotations, ci::Vec3f scale );
+    void setTransform( ci::Matrix44f m );
+
+    ci::Vec3f       getTranslate();
+    ci::Quatf       getRotate();
+    ci::Vec3f       getScale();
+    ci::Matrix44f   getTransform();
+
+    void unregisterEvents();
+
+    bool resize( ci::app::ResizeEvent event );
+
+protected:
+
+    GizmoCore();
+
+    void setup( ci::Vec2i viewportSize, float gizmoScale, float samplingDefinition );
+
+    // Per mode code paths, only the modes actually used get instantiated
+    template< typename Mode > void setMatricesMode( ci::CameraPersp cam );
+    template< typename Mode > void drawMode();
+    template< typename Mode > void mouseDownMode( ci::app::MouseEvent event );
+    template< typename Mode > void mouseMoveMode( ci::app::MouseEvent event );
+    template< typename Mode > void mouseDragMode( ci::app::MouseEvent event );
+    template< typename Mode > void planeMouseDrag( ci::app::MouseEvent event );
+
+    void planeMouseDown( ci::app::MouseEvent event );
+
+    int samplePosition( int x, int y );
+
+    static unsigned int charToInt( unsigned char r, unsigned char g, unsigned char b ){
+        return b + (g << 8) + (r << 16);
+    };
+
+    void transform();
+    void decompose();
+
+
+    static ci::ColorA RED, GREEN, BLUE, YELLOW;
+
+
+    ci::gl::Fbo     mPositionFbo;
+    ci::gl::Fbo     mCursorFbo;
+
+    ci::Vec3f       mPosition;
+    ci::Quatf       mRotations;
+    ci::Vec3f       mScale;
+
+    ci::Arcball     mArcball;
+
+    ci::Matrix44f   mTransform;
+    ci::Matrix44f   mUnscaledTransform;
+
+    ci::CameraPersp mCurrentCam;
+    ci::Matrix44f   mModelView;
+    ci::Matrix44f   mProjection;
+    ci::Rectf       mWindowSize;
+    ci::Area        mViewport;
+
+    int             mSelectedAxis;
+    ci::Vec3f       mMousePos;
+
+	float			mSize;
+
+    bool            mCanRotate;
+
+    std::vector< ci::CallbackId >	mCallbackIds;
+
+};
+
+
+template< typename Mode >
+void GizmoCore::setMatricesMode( ci::CameraPersp cam ){
+
+    mCurrentCam = cam;
+    mProjection = cam.getProjectionMatrix();
+    mModelView  = cam.getModelViewMatrix();
+
+    // Render Gizmo positions to the Fbo
+    mPositionFbo.bindFramebuffer();
+
+    ci::gl::setMatricesWindowPersp( mPositionFbo.getSize() );
+	ci::gl::setMatrices( cam );
+
+    ci::gl::clear( ci::ColorA( 0.0f, 0.0f, 0.0f, 0.0f ) );
+
+    ci::gl::pushModelView();
+
+    // Mult by the unscaled matrix so we don't get non-uniform scales on our graphics
+    ci::gl::multModelView( mUnscaledTransform );
+
+    ci::gl::enableDepthRead();
+    ci::gl::enableDepthWrite();
+
+    // Scale the graphics so they look always the same size on the screen
+    float scale = mSize * ( mTransform.getTranslate() - mCurrentCam.getEyePoint() ).length() / 200.0f;
+    ci::gl::scale( scale, scale, scale );
+
+	glLineWidth( 3.0f );
+
+    // Draw Gizmo graphics
+    Mode::draw( this, RED, GREEN, BLUE );
+
+	glLineWidth( 1.0f );
+
+    ci::gl::disableDepthRead();
+    ci::gl::disableDepthWrite();
+
+    ci::gl::popModelView();
+    mPositionFbo.unbindFramebuffer();
+}
+
+template< typename Mode >
+void GizmoCore::drawMode(){
+    ci::gl::pushModelView();
+
+    // Mult by the unscaled matrix so we don't get non-uniform scales on our graphics
+    ci::gl::multModelView( mUnscaledTransform );
+
+    // Scale the graphics so they look always the same size on the screen
+    float scale = mSize * ( mTransform.getTranslate() - mCurrentCam.getEyePoint() ).length() / 200.0f;
+    ci::gl::scale( scale, scale, scale );
+
+    // Draw Gizmo graphics and highlight selected axis
+    Mode::draw( this,
+                mSelectedAxis == 0 ? YELLOW : RED,
+                mSelectedAxis == 1 ? YELLOW : GREEN,
+                mSelectedAxis == 2 ? YELLOW : BLUE );
+
+    ci::gl::popModelView();
+}
+
+template< typename Mode >
+void GizmoCore::mouseDownMode( ci::app::MouseEvent event ){
+    Mode::mouseDown( this, event );
+}
+
+template< typename Mode >
+void GizmoCore::mouseMoveMode( ci::app::MouseEvent event ){
+    mSelectedAxis = samplePosition( (float) event.getPos().x / (float) ci::app::getWindowWidth() * (float) mPositionFbo.getWidth(), (float) event.getPos().y  / (float) ci::app::getWindowHeight() * (float) mPositionFbo.getHeight() );
+
+    mCanRotate = false;
+    if( mSelectedAxis != -1 || Mode::ID == ROTATE ){
+        // Check if inside rotation center
+        if( ( event.getPos() - mCurrentCam.worldToScreen( mPosition, mWindowSize.getWidth(), mWindowSize.getHeight() ) ).length() < 100.0f ){
+            mCanRotate = true;
+        }
+    }
+}
+
+template< typename Mode >
+void GizmoCore::mouseDragMode( ci::app::MouseEvent event ){
+    Mode::mouseDrag( this, event );
+}
+
+template< typename Mode >
+void GizmoCore::planeMouseDrag( ci::app::MouseEvent event ){
+
+    // Find the plane and the current axis
+    ci::Vec3f currentAxis;
+    ci::Planef currentPlane;
+    switch( mSelectedAxis ){
+        case 0: currentAxis = ci::Vec3f::xAxis(); currentPlane = ci::Planef( ci::Vec3f::zero(), ci::Vec3f::yAxis() ); break;
+        case 1: currentAxis = ci::Vec3f::yAxis(); currentPlane = ci::Planef( ci::Vec3f::zero(), ci::Vec3f::zAxis() ); break;
+        case 2: currentAxis = ci::Vec3f::zAxis(); currentPlane = ci::Planef( ci::Vec3f::zero(), ci::Vec3f::yAxis() ); break;
+        default: return;
+    }
+
+    // Cast a ray from the camera
+    float intersectionDistance;
+    ci::Ray ray = mCurrentCam.generateRay( event.getPos().x / (float) mWindowSize.getWidth(), 1.0f - event.getPos().y / (float) mWindowSize.getHeight(), mWindowSize.getWidth() / (float) mWindowSize.getHeight() );
+
+    // Transform the plane point and normal so it relfects our rotations
+    bool intersect = ray.calcPlaneIntersection( mPosition + mRotations.toMatrix33() * currentPlane.getPoint(), mRotations.toMatrix33() * currentPlane.getNormal(), &intersectionDistance );
+
+    // And check if there's an intersection with the plane
+    if( intersect ){
+
+        // Use that to move, rotate or scale
+        ci::Vec3f intersection = ray.getOrigin() + ray.getDirection() * intersectionDistance;
+        ci::Vec3f diff = ( intersection - mMousePos );
+        if( diff.length() < 50.0f ){
+            diff *= currentAxis;
+            Mode::apply( this, diff );
+            transform();
+        }
+
+        // Keep the last mouse position
+        mMousePos = intersection;
+    }
+}
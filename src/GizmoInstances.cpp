@@ -0,0 +1,68 @@
+//
+//  GizmoInstances.cpp
+//  SceneGraph
+//
+
+#include "GizmoInstances.h"
+
+#include "cinder/Thread.h"
+
+#include <algorithm>
+
+
+namespace {
+
+    void buildGizmoInstanceRange( const GizmoInstanceSource *sources, GizmoInstance *instances, size_t count, ci::Vec3f eyePoint, float gizmoScale ){
+        for( size_t i = 0; i < count; ++i ){
+            const GizmoInstanceSource &source = sources[i];
+            GizmoInstance &instance = instances[i];
+
+            // Same as GizmoCore::transform without the scale
+            instance.mTransform.setToIdentity();
+            instance.mTransform.translate( source.mPosition );
+            instance.mTransform *= source.mRotations;
+
+            // Same as GizmoCore::drawMode, so they look always the same size on the screen
+            instance.mScale         = gizmoScale * ( source.mPosition - eyePoint ).length() / 200.0f;
+            instance.mSelectedAxis  = source.mSelectedAxis;
+        }
+    }
+
+    void joinThreads( std::vector< std::thread* > *threads ){
+        for( size_t i = 0; i < threads->size(); ++i ){
+            (*threads)[i]->join();
+            delete (*threads)[i];
+        }
+        threads->clear();
+    }
+}
+
+
+void buildGizmoInstances( const std::vector< GizmoInstanceSource > &sources, ci::Vec3f eyePoint, float gizmoScale, std::vector< GizmoInstance > *instances, size_t numThreads ){
+    instances->resize( sources.size() );
+    if( sources.empty() ) return;
+
+    numThreads = std::max< size_t >( std::min( numThreads, sources.size() ), 1 );
+
+    // Each thread writes its own contiguous chunk, the calling thread takes the last one
+    size_t chunkSize = sources.size() / numThreads;
+    size_t last = ( numThreads - 1 ) * chunkSize;
+
+    // Reserved up front so push_back can't throw once a thread is running
+    std::vector< std::thread* > threads;
+    threads.reserve( numThreads - 1 );
+
+    try {
+        for( size_t i = 0; i < numThreads - 1; ++i ){
+            threads.push_back( new std::thread( &buildGizmoInstanceRange, &sources[ i * chunkSize ], &(*instances)[ i * chunkSize ], chunkSize, eyePoint, gizmoScale ) );
+        }
+        buildGizmoInstanceRange( &sources[ last ], &(*instances)[ last ], sources.size() - last, eyePoint, gizmoScale );
+    }
+    catch( ... ){
+        // Never leave a joinable thread behind
+        joinThreads( &threads );
+        throw;
+    }
+
+    joinThreads( &threads );
+}
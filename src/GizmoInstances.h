@@ -0,0 +1,35 @@
+//
+//  GizmoInstances.h
+//  SceneGraph
+//
+//  Per-instance data used by GizmoBatch. Nothing here depends on
+//  OpenGL, so the instance buffer can be built and checked without
+//  a context.
+//
+
+#pragma once
+
+#include "cinder/Vector.h"
+#include "cinder/Quaternion.h"
+#include "cinder/Matrix.h"
+
+#include <vector>
+
+
+// What the user adds for each gizmo
+struct GizmoInstanceSource {
+    ci::Vec3f       mPosition;
+    ci::Quatf       mRotations;
+    int             mSelectedAxis;
+};
+
+// What gets uploaded for each gizmo, the layout matches GizmoBatch's shader attributes
+struct GizmoInstance {
+    ci::Matrix44f   mTransform;     // unscaled transform, column major
+    float           mScale;         // screen constant scale
+    float           mSelectedAxis;  // -1, 0, 1 or 2
+};
+
+// Fills instances from sources. Runs on the calling thread unless numThreads
+// is bigger than 1, in which case the work is split in contiguous chunks.
+void buildGizmoInstances( const std::vector< GizmoInstanceSource > &sources, ci::Vec3f eyePoint, float gizmoScale, std::vector< GizmoInstance > *instances, size_t numThreads = 1 );
@@ -0,0 +1,140 @@
+//
+//  GizmoModes.h
+//  SceneGraph
+//
+//  Translate, rotate and scale policies. Each one holds the drawing and
+//  mouse handling of its mode; they're only reachable through GizmoCore
+//  so the gizmo's event flow can't be bypassed.
+//
+
+#pragma once
+
+#include "GizmoCore.h"
+
+
+class GizmoCore::TranslateMode {
+public:
+    static const int ID = TRANSLATE;
+
+private:
+    friend class GizmoCore;
+
+    static void draw( GizmoCore *, ci::ColorA xColor, ci::ColorA yColor, ci::ColorA zColor ){
+        float axisLength = 30.0f;
+        float headLength = 6.0f;
+        float headRadius = 1.5f;
+
+        ci::gl::color( xColor );
+        ci::gl::drawVector( ci::Vec3f::zero(), ci::Vec3f::xAxis() * axisLength, headLength, headRadius );
+        ci::gl::color( yColor );
+        ci::gl::drawVector( ci::Vec3f::zero(), ci::Vec3f::yAxis() * axisLength, headLength, headRadius );
+        ci::gl::color( zColor );
+        ci::gl::drawVector( ci::Vec3f::zero(), ci::Vec3f::zAxis() * axisLength, headLength, headRadius );
+    }
+
+    static void mouseDown( GizmoCore *gizmo, ci::app::MouseEvent event ){
+        gizmo->planeMouseDown( event );
+    }
+    static void mouseDrag( GizmoCore *gizmo, ci::app::MouseEvent event ){
+        gizmo->planeMouseDrag< TranslateMode >( event );
+    }
+    static void apply( GizmoCore *gizmo, ci::Vec3f diff ){
+        // Transform the translation to match the current rotations
+        gizmo->mPosition -= gizmo->mRotations.toMatrix33() * diff;
+    }
+};
+
+
+class GizmoCore::RotateMode {
+public:
+    static const int ID = ROTATE;
+
+private:
+    friend class GizmoCore;
+
+    static void draw( GizmoCore *gizmo, ci::ColorA xColor, ci::ColorA yColor, ci::ColorA zColor ){
+        float axisLength = 30.0f;
+        float radius = 2.0f;
+        float slices = 30;
+
+        glEnable( GL_CULL_FACE );
+        glCullFace( GL_BACK );
+
+        ci::gl::color( xColor );
+        ci::gl::drawCylinder( axisLength, axisLength, radius, slices );
+
+        ci::gl::color( yColor );
+        ci::gl::pushModelView();
+        ci::gl::rotate( ci::Vec3f::zAxis() * 90 );
+        ci::gl::drawCylinder( axisLength, axisLength, radius, slices );
+        ci::gl::popModelView();
+
+        ci::gl::color( zColor );
+        ci::gl::pushModelView();
+        ci::gl::rotate( ci::Vec3f::xAxis() * 90 );
+        ci::gl::drawCylinder( axisLength, axisLength, radius, slices );
+        ci::gl::popModelView();
+
+        glDisable( GL_CULL_FACE );
+
+        ci::gl::pushMatrices();
+        ci::gl::color( 0.3f, 0.3f, 0.3f );
+        ci::gl::setMatricesWindow( ci::Vec2i( gizmo->mWindowSize.getWidth(), gizmo->mWindowSize.getHeight() ) );
+        ci::gl::drawStrokedCircle( gizmo->mCurrentCam.worldToScreen( gizmo->mPosition, gizmo->mWindowSize.getWidth(), gizmo->mWindowSize.getHeight() ), 100 );
+        ci::gl::popMatrices();
+    }
+
+    // Use Arcball instead of the raycasting trick
+    static void mouseDown( GizmoCore *gizmo, ci::app::MouseEvent event ){
+        switch( gizmo->mSelectedAxis ){
+            case 0: gizmo->mArcball.setConstraintAxis( gizmo->mRotations * -ci::Vec3f::yAxis() ); break;
+            case 1: gizmo->mArcball.setConstraintAxis( gizmo->mRotations * ci::Vec3f::xAxis() ); break;
+            case 2: gizmo->mArcball.setConstraintAxis( gizmo->mRotations * ci::Vec3f::zAxis() ); break;
+            default: gizmo->mArcball.setNoConstraintAxis(); break;
+        }
+        gizmo->mArcball.mouseDown( event.getPos() );
+    }
+    static void mouseDrag( GizmoCore *gizmo, ci::app::MouseEvent event ){
+        if( gizmo->mCanRotate ){
+            gizmo->mArcball.mouseDrag( event.getPos() );
+            gizmo->mRotations = gizmo->mArcball.getQuat();
+            gizmo->transform();
+        }
+        else gizmo->planeMouseDrag< RotateMode >( event );
+    }
+    static void apply( GizmoCore *, ci::Vec3f ){}
+};
+
+
+class GizmoCore::ScaleMode {
+public:
+    static const int ID = SCALE;
+
+private:
+    friend class GizmoCore;
+
+    static void draw( GizmoCore *, ci::ColorA xColor, ci::ColorA yColor, ci::ColorA zColor ){
+        float axisLength = 30.0f;
+        ci::Vec3f handleSize = ci::Vec3f( 3.0f, 3.0f, 3.0f );
+
+        ci::gl::color( xColor );
+        ci::gl::drawLine( ci::Vec3f::zero(), ci::Vec3f::xAxis() * axisLength );
+        ci::gl::drawCube( ci::Vec3f::xAxis() * axisLength, handleSize );
+        ci::gl::color( yColor );
+        ci::gl::drawLine( ci::Vec3f::zero(), ci::Vec3f::yAxis() * axisLength );
+        ci::gl::drawCube( ci::Vec3f::yAxis() * axisLength, handleSize );
+        ci::gl::color( zColor );
+        ci::gl::drawLine( ci::Vec3f::zero(), ci::Vec3f::zAxis() * axisLength );
+        ci::gl::drawCube( ci::Vec3f::zAxis() * axisLength, handleSize );
+    }
+
+    static void mouseDown( GizmoCore *gizmo, ci::app::MouseEvent event ){
+        gizmo->planeMouseDown( event );
+    }
+    static void mouseDrag( GizmoCore *gizmo, ci::app::MouseEvent event ){
+        gizmo->planeMouseDrag< ScaleMode >( event );
+    }
+    static void apply( GizmoCore *gizmo, ci::Vec3f diff ){
+        gizmo->mScale += diff * 0.01f;
+    }
+};
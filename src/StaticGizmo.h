@@ -0,0 +1,77 @@
+//
+//  StaticGizmo.h
+//  SceneGraph
+//
+//  Gizmo fixed to a single mode at compile time. It only builds on
+//  GizmoCore, so the other modes and Gizmo's runtime switching are
+//  never referenced.
+//
+
+#pragma once
+
+#include "GizmoCore.h"
+#include "GizmoModes.h"
+
+
+// GizmoCore is a protected base so the transform can't be reached
+// through anything else than the fixed mode's event flow.
+template< typename Mode >
+class StaticGizmo : protected GizmoCore {
+public:
+    
+    static std::shared_ptr< StaticGizmo > create( ci::Vec2i viewportSize, bool autoRegisterEvents = true, float gizmoScale = 1.0f, float samplingDefinition = 0.5f ){
+        std::shared_ptr< StaticGizmo > gizmo = std::shared_ptr< StaticGizmo >( new StaticGizmo() );
+        gizmo->setup( viewportSize, gizmoScale, samplingDefinition );
+        
+        if( autoRegisterEvents ) gizmo->registerEvents();
+        
+        return gizmo;
+    }
+    
+    void setMatrices( ci::CameraPersp cam ){ setMatricesMode< Mode >( cam ); }
+    
+    void draw(){ drawMode< Mode >(); }
+    
+    using GizmoCore::setTranslate;
+    using GizmoCore::setRotate;
+    using GizmoCore::setScale;
+    using GizmoCore::setTransform;
+    
+    using GizmoCore::getTranslate;
+    using GizmoCore::getRotate;
+    using GizmoCore::getScale;
+    using GizmoCore::getTransform;
+    
+    void registerEvents(){
+        mCallbackIds.push_back( ci::app::App::get()->registerMouseDown( this, &StaticGizmo::mouseDown ) );
+        mCallbackIds.push_back( ci::app::App::get()->registerMouseMove( this, &StaticGizmo::mouseMove ) );
+        mCallbackIds.push_back( ci::app::App::get()->registerMouseDrag( this, &StaticGizmo::mouseDrag ) );
+        mCallbackIds.push_back( ci::app::App::get()->registerResize( this, &StaticGizmo::resize ) );
+    }
+    using GizmoCore::unregisterEvents;
+    
+    bool mouseDown( ci::app::MouseEvent event ){
+        mouseDownMode< Mode >( event );
+        return false;
+    }
+    bool mouseMove( ci::app::MouseEvent event ){
+        mouseMoveMode< Mode >( event );
+        return false;
+    }
+    bool mouseDrag( ci::app::MouseEvent event ){
+        mouseDragMode< Mode >( event );
+        return false;
+    }
+    bool resize( ci::app::ResizeEvent event ){
+        return GizmoCore::resize( event );
+    }
+    
+protected:
+    
+    StaticGizmo(){}
+    
+};
+
+typedef std::shared_ptr< StaticGizmo< GizmoCore::TranslateMode > >  TranslateGizmoRef;
+typedef std::shared_ptr< StaticGizmo< GizmoCore::RotateMode > >     RotateGizmoRef;
+typedef std::shared_ptr< StaticGizmo< GizmoCore::ScaleMode > >      ScaleGizmoRef;
@@ -0,0 +1,95 @@
+//
+//  GizmoInstancesTest.cpp
+//  SceneGraph
+//
+//  Checks buildGizmoInstances without an OpenGL context:
+//
+//  g++ -I../src -I<cinder>/include -I<cinder>/boost GizmoInstancesTest.cpp ../src/GizmoInstances.cpp -lboost_thread -lboost_system
+//
+
+#include "GizmoInstances.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+
+static int sFailures = 0;
+
+static void check( bool condition, const char *what ){
+    if( ! condition ){
+        std::printf( "FAILED: %s\n", what );
+        sFailures++;
+    }
+}
+
+static bool near( ci::Vec3f a, ci::Vec3f b ){
+    return ( a - b ).length() < 1e-4f;
+}
+
+static void testInstances(){
+    std::vector< GizmoInstanceSource > sources;
+    GizmoInstanceSource a = { ci::Vec3f( 10.0f, 0.0f, 0.0f ), ci::Quatf(), -1 };
+    GizmoInstanceSource b = { ci::Vec3f( 0.0f, 5.0f, -3.0f ), ci::Quatf( ci::Vec3f::yAxis(), M_PI * 0.5f ), 0 };
+    GizmoInstanceSource c = { ci::Vec3f( 1.0f, 2.0f, 3.0f ), ci::Quatf( ci::Vec3f::zAxis(), M_PI ), 2 };
+    sources.push_back( a );
+    sources.push_back( b );
+    sources.push_back( c );
+    
+    ci::Vec3f eyePoint( 0.0f, 0.0f, 400.0f );
+    std::vector< GizmoInstance > instances;
+    buildGizmoInstances( sources, eyePoint, 2.0f, &instances );
+    
+    check( instances.size() == sources.size(), "one instance per source" );
+    for( size_t i = 0; i < sources.size(); ++i ){
+        const GizmoInstanceSource &source = sources[i];
+        const GizmoInstance &instance = instances[i];
+        
+        // Unscaled transform: translation then rotation
+        check( near( instance.mTransform.transformPoint( ci::Vec3f::zero() ), source.mPosition ), "transform translates to the position" );
+        check( near( instance.mTransform.transformPoint( ci::Vec3f::xAxis() ), source.mPosition + source.mRotations * ci::Vec3f::xAxis() ), "transform rotates the x axis" );
+        check( near( instance.mTransform.transformPoint( ci::Vec3f::yAxis() ), source.mPosition + source.mRotations * ci::Vec3f::yAxis() ), "transform rotates the y axis" );
+        
+        float scale = 2.0f * ( source.mPosition - eyePoint ).length() / 200.0f;
+        check( std::fabs( instance.mScale - scale ) < 1e-5f, "screen constant scale" );
+        check( instance.mSelectedAxis == (float) source.mSelectedAxis, "selected axis" );
+    }
+}
+
+static void testThreads(){
+    std::vector< GizmoInstanceSource > sources;
+    std::srand( 42 );
+    for( int i = 0; i < 10007; ++i ){
+        GizmoInstanceSource source = {
+            ci::Vec3f( std::rand() % 1000 - 500.0f, std::rand() % 1000 - 500.0f, std::rand() % 1000 - 500.0f ),
+            ci::Quatf( ci::Vec3f( 1.0f, std::rand() % 10 / 10.0f, 0.5f ).normalized(), std::rand() % 628 / 100.0f ),
+            i % 4 - 1
+        };
+        sources.push_back( source );
+    }
+    
+    std::vector< GizmoInstance > serial;
+    buildGizmoInstances( sources, ci::Vec3f( 0.0f, 300.0f, 500.0f ), 1.0f, &serial );
+    
+    size_t numThreads[] = { 2, 3, 8 };
+    for( size_t t = 0; t < 3; ++t ){
+        std::vector< GizmoInstance > threaded;
+        buildGizmoInstances( sources, ci::Vec3f( 0.0f, 300.0f, 500.0f ), 1.0f, &threaded, numThreads[t] );
+        check( threaded.size() == serial.size() && std::memcmp( &threaded[0], &serial[0], serial.size() * sizeof( GizmoInstance ) ) == 0, "threaded build matches the serial one" );
+    }
+    
+    std::vector< GizmoInstanceSource > none;
+    std::vector< GizmoInstance > empty( 3 );
+    buildGizmoInstances( none, ci::Vec3f::zero(), 1.0f, &empty, 4 );
+    check( empty.empty(), "no sources gives no instances" );
+}
+
+int main(){
+    testInstances();
+    testThreads();
+    
+    if( sFailures ) return EXIT_FAILURE;
+    std::printf( "GizmoInstances: all checks passed\n" );
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,27 @@
+//
+//  GizmoSize.cpp
+//  SceneGraph
+//
+//  Code size check, paired with StaticGizmoSize.cpp: same calls on the
+//  runtime switching Gizmo, which needs GizmoCore.cpp and Gizmo.cpp.
+//
+//  g++ -O2 -I../src -I<cinder>/include GizmoSize.cpp ../src/GizmoCore.cpp ../src/Gizmo.cpp <cinder libs> -o GizmoSize
+//  size GizmoSize && nm -C GizmoSize | grep -E "RotateMode|ScaleMode|Gizmo::"
+//
+
+#include "Gizmo.h"
+
+
+int main(){
+    GizmoRef gizmo = Gizmo::create( ci::Vec2i( 640, 480 ) );
+    gizmo->setTranslate( ci::Vec3f( 10.0f, 0.0f, 0.0f ) );
+    
+    gizmo->setMatrices( ci::CameraPersp() );
+    gizmo->draw();
+    
+    gizmo->mouseMove( ci::app::MouseEvent() );
+    gizmo->mouseDown( ci::app::MouseEvent() );
+    gizmo->mouseDrag( ci::app::MouseEvent() );
+    
+    return gizmo->getTranslate().x > 0.0f ? 0 : 1;
+}
@@ -0,0 +1,27 @@
+//
+//  StaticGizmoSize.cpp
+//  SceneGraph
+//
+//  Code size check, paired with GizmoSize.cpp: same calls on a
+//  StaticGizmo< TranslateMode >, which only needs GizmoCore.cpp.
+//
+//  g++ -O2 -I../src -I<cinder>/include StaticGizmoSize.cpp ../src/GizmoCore.cpp <cinder libs> -o StaticGizmoSize
+//  size StaticGizmoSize && nm -C StaticGizmoSize | grep -E "RotateMode|ScaleMode|Gizmo::"
+//
+
+#include "StaticGizmo.h"
+
+
+int main(){
+    TranslateGizmoRef gizmo = StaticGizmo< GizmoCore::TranslateMode >::create( ci::Vec2i( 640, 480 ) );
+    gizmo->setTranslate( ci::Vec3f( 10.0f, 0.0f, 0.0f ) );
+    
+    gizmo->setMatrices( ci::CameraPersp() );
+    gizmo->draw();
+    
+    gizmo->mouseMove( ci::app::MouseEvent() );
+    gizmo->mouseDown( ci::app::MouseEvent() );
+    gizmo->mouseDrag( ci::app::MouseEvent() );
+    
+    return gizmo->getTranslate().x > 0.0f ? 0 : 1;
+}